@@ -1,5 +1,6 @@
 #include <pebble.h>
 #include <locale.h>
+#include "worker_shared.h"
 
 // Main window and layers
 static Window *s_window;
@@ -30,6 +31,32 @@ static int s_step_goal = 8000;
 static int s_current_steps = 0;
 static bool s_show_hour_numbers = false;
 
+// Seconds indicator
+#define SECONDS_MARKER_SIZE 9          // Marker layer is this many pixels square
+#define SECONDS_MIN_BATTERY 20         // Switch off at or below this charge (unless charging)
+
+static Layer *s_seconds_layer;
+static bool s_show_seconds = false;    // User setting
+static bool s_seconds_active = false;  // Setting, focus and battery all allow it
+static bool s_has_focus = true;
+
+// Snapshot of the last full canvas render, replayed on seconds-only frames
+static GBitmap *s_canvas_cache;
+static bool s_canvas_cache_valid = false;
+
+// Seconds mode cost, logged when it switches off
+typedef struct {
+  time_t started;
+  uint8_t battery_at_start;
+  uint32_t ticks;
+} SecondsStats;
+
+static SecondsStats s_seconds_stats;
+
+// Background worker supplies steps and battery; without it the face polls itself
+static bool s_worker_active = false;
+static BatteryChargeState s_worker_battery;
+
 // Twilight data (minutes since midnight UTC)
 typedef struct {
   int16_t astronomical_twilight_begin;
@@ -44,6 +71,7 @@ typedef struct {
 } TwilightData;
 
 static TwilightData s_twilight;
+static bool s_twilight_unsaved = false;   // Table data isn't persisted; flash is behind RAM
 
 // Persistent storage keys
 #define STORAGE_KEY_TWILIGHT 1
@@ -51,8 +79,47 @@ static TwilightData s_twilight;
 
 #define STORAGE_KEY_TWILIGHT 1
 #define STORAGE_KEY_DATE_CONFIG 2
-#define STORAGE_KEY_STEP_GOAL 3
+// STORAGE_KEY_STEP_GOAL (3) is shared with the worker, see worker_shared.h
 #define STORAGE_KEY_SHOW_HOUR_NUMBERS 4
+#define STORAGE_KEY_TWILIGHT_STAMP 5
+#define STORAGE_KEY_SHOW_SECONDS 6
+#define STORAGE_KEY_TABLE_LOCATION 7
+#define STORAGE_KEY_WORKER_DECLINED 8   // When the replace-worker prompt was last shown
+
+#define WORKER_RETRY_S SECONDS_PER_DAY    // Don't prompt again for this long
+
+// Year-ahead twilight table for saved locations (tools/generate_twilight_table.js)
+#define TABLE_HEADER_SIZE 12
+#define TABLE_RECORD_SIZE 16
+#define TABLE_VERSION 2
+
+static int s_table_location = -1;    // Saved location in use, -1 = phone data
+
+// When, and for which timezone, the twilight data was received
+typedef struct {
+  time_t received;
+  char timezone[TIMEZONE_NAME_LENGTH];
+} TwilightStamp;
+
+static TwilightStamp s_twilight_stamp;
+static time_t s_twilight_stamp_saved;   // received time of the copy in flash
+
+// Refresh scheduler
+#define REFRESH_MAX_AGE_S (6 * SECONDS_PER_HOUR)      // Re-check location this often
+#define REFRESH_TIMEOUT_S (2 * SECONDS_PER_MINUTE)    // No reply by then counts as a failure
+#define REFRESH_BACKOFF_MIN_S SECONDS_PER_MINUTE
+#define REFRESH_BACKOFF_MAX_S (64 * SECONDS_PER_MINUTE)
+#define REFRESH_TABLE_MAX_AGE_S (24 * SECONDS_PER_HOUR) // Location re-check when on the table
+
+typedef struct {
+  bool connected;           // Phone app connected
+  bool js_ready;            // PebbleKit JS has announced itself
+  time_t request_sent;      // 0 when no request is in flight
+  time_t next_attempt;      // No request before this (backoff)
+  uint32_t backoff_s;
+} RefreshScheduler;
+
+static RefreshScheduler s_refresh;
 
 // Color palettes for different platforms
 #ifdef PBL_COLOR
@@ -71,6 +138,7 @@ static TwilightData s_twilight;
   #define COLOR_CHARGING GColorWhite
   #define COLOR_SEPARATOR GColorWhite
   #define COLOR_STEP_TRACKER GColorJazzberryJam
+  #define COLOR_SECONDS GColorWhite
 #else
   #define COLOR_DAY GColorWhite
   #define COLOR_CIVIL_TWILIGHT GColorLightGray
@@ -90,6 +158,7 @@ static TwilightData s_twilight;
   #define COLOR_CHARGING GColorDarkGray
   #define COLOR_SEPARATOR GColorWhite
   #define COLOR_STEP_TRACKER GColorDarkGray
+  #define COLOR_SECONDS GColorWhite
 #endif
 
 #define BATTERY_RING_WIDTH 10
@@ -97,6 +166,38 @@ static TwilightData s_twilight;
 #define SEPARATOR_WIDTH 1
 #define TWILIGHT_RING_WIDTH 20
 
+// Benchmark (time-lapse replay) mode
+#define BENCH_FRAME_INTERVAL_MS 50     // Fixed 20 fps
+#define BENCH_DAY_STEP_MINUTES 5       // 288 frames per replayed day
+#define BENCH_YEAR_DAYS 365            // One frame per day in year replay
+#define BENCH_YEAR_DRIFT_MINUTES 37    // Moves the hands between year frames
+
+typedef enum {
+  BENCH_OFF,
+  BENCH_DAY,
+  BENCH_YEAR
+} BenchMode;
+
+typedef struct {
+  BenchMode mode;
+  AppTimer *timer;
+  time_t sim_time;          // Simulated clock driving the renderer
+  uint16_t frame;
+  uint16_t total_frames;
+  bool frame_pending;       // Frame marked dirty but not yet rendered
+  uint8_t sim_battery;
+  bool sim_charging;
+  int sim_steps;
+  TwilightData sim_twilight;
+  uint16_t rendered;
+  uint16_t dropped;
+  uint32_t min_ms;
+  uint32_t max_ms;
+  uint32_t total_ms;
+} BenchState;
+
+static BenchState s_bench;
+
 // Convert minutes since midnight to angle (0° = top/noon, 180° = bottom/midnight)
 static int32_t minutes_to_angle(int minutes) {
   // 24 hour clock: 1440 minutes per full rotation
@@ -116,6 +217,44 @@ static int32_t minutes_to_angle(int minutes) {
 //  return t->tm_hour * 60 + t->tm_min;
 //}
 
+// Time shown on the face: the simulated clock while benchmarking, otherwise now
+static struct tm *get_display_time() {
+  time_t now = (s_bench.mode != BENCH_OFF) ? s_bench.sim_time : time(NULL);
+  return localtime(&now);
+}
+
+// Twilight data shown on the face (synthetic during a year replay)
+static const TwilightData *get_display_twilight() {
+  return (s_bench.mode == BENCH_YEAR) ? &s_bench.sim_twilight : &s_twilight;
+}
+
+// Battery state shown on the face (simulated while benchmarking)
+static BatteryChargeState get_display_battery() {
+  if (s_bench.mode != BENCH_OFF) {
+    return (BatteryChargeState) {
+      .charge_percent = s_bench.sim_battery,
+      .is_charging = s_bench.sim_charging,
+    };
+  }
+  if (s_worker_active) {
+    return s_worker_battery;
+  }
+  return battery_state_service_peek();
+}
+
+// Step count shown on the face (simulated while benchmarking)
+static int get_display_steps() {
+  return (s_bench.mode != BENCH_OFF) ? s_bench.sim_steps : s_current_steps;
+}
+
+// Redraw the whole face (the seconds marker alone doesn't need this)
+static void mark_canvas_dirty() {
+  s_canvas_cache_valid = false;
+  if (s_canvas_layer) {
+    layer_mark_dirty(s_canvas_layer);
+  }
+}
+
 // Determine period type based on current time
 typedef enum {
   PERIOD_NIGHT,
@@ -129,21 +268,22 @@ typedef enum {
 } PeriodType;
 
 static PeriodType get_current_period(int current_minutes) {
-  if (!s_twilight.valid) return PERIOD_DAY;
+  const TwilightData *tw = get_display_twilight();
+  if (!tw->valid) return PERIOD_DAY;
   
-  if (current_minutes >= s_twilight.sunrise && current_minutes < s_twilight.sunset) {
+  if (current_minutes >= tw->sunrise && current_minutes < tw->sunset) {
     return PERIOD_DAY;
-  } else if (current_minutes >= s_twilight.civil_twilight_begin && current_minutes < s_twilight.sunrise) {
+  } else if (current_minutes >= tw->civil_twilight_begin && current_minutes < tw->sunrise) {
     return PERIOD_CIVIL_TWILIGHT_DAWN;
-  } else if (current_minutes >= s_twilight.sunset && current_minutes < s_twilight.civil_twilight_end) {
+  } else if (current_minutes >= tw->sunset && current_minutes < tw->civil_twilight_end) {
     return PERIOD_CIVIL_TWILIGHT_DUSK;
-  } else if (current_minutes >= s_twilight.nautical_twilight_begin && current_minutes < s_twilight.civil_twilight_begin) {
+  } else if (current_minutes >= tw->nautical_twilight_begin && current_minutes < tw->civil_twilight_begin) {
     return PERIOD_NAUTICAL_TWILIGHT_DAWN;
-  } else if (current_minutes >= s_twilight.civil_twilight_end && current_minutes < s_twilight.nautical_twilight_end) {
+  } else if (current_minutes >= tw->civil_twilight_end && current_minutes < tw->nautical_twilight_end) {
     return PERIOD_NAUTICAL_TWILIGHT_DUSK;
-  } else if (current_minutes >= s_twilight.astronomical_twilight_begin && current_minutes < s_twilight.nautical_twilight_begin) {
+  } else if (current_minutes >= tw->astronomical_twilight_begin && current_minutes < tw->nautical_twilight_begin) {
     return PERIOD_ASTRONOMICAL_TWILIGHT_DAWN;
-  } else if (current_minutes >= s_twilight.nautical_twilight_end && current_minutes < s_twilight.astronomical_twilight_end) {
+  } else if (current_minutes >= tw->nautical_twilight_end && current_minutes < tw->astronomical_twilight_end) {
     return PERIOD_ASTRONOMICAL_TWILIGHT_DUSK;
   } else {
     return PERIOD_NIGHT;
@@ -152,8 +292,7 @@ static PeriodType get_current_period(int current_minutes) {
 
 // Update date display
 static void update_date_display() {
-  time_t now = time(NULL);
-  struct tm *t = localtime(&now);
+  struct tm *t = get_display_time();
   
   // Format date based on configuration
   if (s_date_config.show_day_of_week) {
@@ -203,10 +342,89 @@ static void get_step_count() {
 static void health_handler(HealthEventType event, void *context) {
   if (event == HealthEventMovementUpdate) {
     get_step_count();
-    if (s_canvas_layer) {
-      layer_mark_dirty(s_canvas_layer);
+    mark_canvas_dirty();
+  }
+}
+
+// Updates pushed by the background worker
+static void worker_message_handler(uint16_t type, AppWorkerMessage *data) {
+  if (type == WORKER_MSG_STEPS) {
+    s_current_steps = (int)(((uint32_t)data->data0 << 16) | data->data1);
+  } else if (type == WORKER_MSG_BATTERY) {
+    s_worker_battery.charge_percent = (uint8_t)data->data0;
+    s_worker_battery.is_charging = data->data1 != 0;
+  } else {
+    return;
+  }
+
+  // The worker only sends values that change what is drawn
+  mark_canvas_dirty();
+}
+
+// Tell the worker the step goal; it answers with fresh steps and battery
+static void send_step_goal_to_worker() {
+  AppWorkerMessage msg = { .data0 = (uint16_t)s_step_goal };
+  app_worker_send_message(WORKER_MSG_STEP_GOAL, &msg);
+}
+
+// Start (or attach to) the background worker, seeding values from its last save.
+// After the user was asked to replace another app's worker, only attach for a
+// day: faces restart after every app exit and would ask again each time.
+static bool start_worker() {
+  if (app_worker_is_running()) {
+    persist_delete(STORAGE_KEY_WORKER_DECLINED);
+  } else {
+    if (persist_exists(STORAGE_KEY_WORKER_DECLINED) &&
+        time(NULL) - persist_read_int(STORAGE_KEY_WORKER_DECLINED) < WORKER_RETRY_S) {
+      APP_LOG(APP_LOG_LEVEL_DEBUG, "Worker prompt shown recently, not relaunching");
+      return false;
+    }
+
+    AppWorkerResult result = app_worker_launch();
+    if (result == APP_WORKER_RESULT_ASKING_CONFIRMATION) {
+      // Accepting starts the worker, which the next launch attaches to
+      persist_write_int(STORAGE_KEY_WORKER_DECLINED, (int32_t)time(NULL));
+      APP_LOG(APP_LOG_LEVEL_WARNING, "Worker needs confirmation, using health events");
+      return false;
+    }
+    if (result != APP_WORKER_RESULT_SUCCESS && result != APP_WORKER_RESULT_ALREADY_RUNNING) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Worker launch failed: %d", (int)result);
+      return false;
     }
   }
+
+  // Ready-made numbers until the worker's first message arrives
+  s_worker_battery = battery_state_service_peek();
+  WorkerAggregates aggregates;
+  if (persist_exists(STORAGE_KEY_WORKER_AGGREGATES) &&
+      persist_read_data(STORAGE_KEY_WORKER_AGGREGATES, &aggregates, sizeof(WorkerAggregates)) == sizeof(WorkerAggregates) &&
+      aggregates.day_start == time_start_of_today()) {
+    s_current_steps = (int)aggregates.steps;
+  }
+
+  app_worker_message_subscribe(worker_message_handler);
+  send_step_goal_to_worker();
+  return true;
+}
+
+// Read steps and battery ourselves when the worker isn't there
+static void start_health_fallback() {
+  if (health_service_events_subscribe(health_handler, NULL)) {
+    // Force initial update
+    get_step_count();
+  } else {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Health not available!");
+  }
+}
+
+// The worker stopped under us (crashed, stopped or replaced); the next launch retries it
+static void check_worker() {
+  if (!s_worker_active || app_worker_is_running()) return;
+
+  APP_LOG(APP_LOG_LEVEL_WARNING, "Worker stopped, using health events");
+  app_worker_message_unsubscribe();
+  s_worker_active = false;
+  start_health_fallback();
 }
 
 // Draw step tracker
@@ -222,7 +440,7 @@ static void draw_step_tracker(GContext *ctx) {
                             tracker_radius * 2, tracker_radius * 2);
 
   // Calculate fill percentage
-  int steps = s_current_steps;
+  int steps = get_display_steps();
   if (steps > s_step_goal) steps = s_step_goal;
   
   int32_t angle_270 = DEG_TO_TRIGANGLE(270);
@@ -244,7 +462,7 @@ static void draw_step_tracker(GContext *ctx) {
 // Draw battery indicator
 static void draw_battery_indicator(GContext *ctx) {
   // Get battery state
-  BatteryChargeState battery_state = battery_state_service_peek();
+  BatteryChargeState battery_state = get_display_battery();
   uint8_t battery_percent = battery_state.charge_percent;
   bool is_charging = battery_state.is_charging;
   
@@ -322,7 +540,8 @@ static void draw_battery_indicator(GContext *ctx) {
 
 // Draw twilight shadows
 static void draw_twilight_shadows(GContext *ctx) {
-  if (!s_twilight.valid) {
+  const TwilightData *tw = get_display_twilight();
+  if (!tw->valid) {
     // APP_LOG(APP_LOG_LEVEL_DEBUG, "Twilight data not valid, skipping shadows");
     return;
   }
@@ -336,33 +555,41 @@ static void draw_twilight_shadows(GContext *ctx) {
   graphics_context_set_fill_color(ctx, COLOR_NIGHT);
   graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, 0, TRIG_MAX_ANGLE);
   
-  // Astronomical twilight
-  int32_t astro_begin = minutes_to_angle(s_twilight.astronomical_twilight_begin);
-  int32_t astro_end = minutes_to_angle(s_twilight.astronomical_twilight_end);
-  graphics_context_set_fill_color(ctx, COLOR_ASTRONOMICAL_TWILIGHT);
-  graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, astro_begin, TRIG_MAX_ANGLE);
-  graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, 0, astro_end);
+  // Astronomical twilight (-1 from the table: the sun never climbs that high today)
+  if (tw->astronomical_twilight_begin >= 0) {
+    int32_t astro_begin = minutes_to_angle(tw->astronomical_twilight_begin);
+    int32_t astro_end = minutes_to_angle(tw->astronomical_twilight_end);
+    graphics_context_set_fill_color(ctx, COLOR_ASTRONOMICAL_TWILIGHT);
+    graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, astro_begin, TRIG_MAX_ANGLE);
+    graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, 0, astro_end);
+  }
   
   // Nautical twilight
-  int32_t naut_begin = minutes_to_angle(s_twilight.nautical_twilight_begin);
-  int32_t naut_end = minutes_to_angle(s_twilight.nautical_twilight_end);
-  graphics_context_set_fill_color(ctx, COLOR_NAUTICAL_TWILIGHT);
-  graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, naut_begin, TRIG_MAX_ANGLE);
-  graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, 0, naut_end);
+  if (tw->nautical_twilight_begin >= 0) {
+    int32_t naut_begin = minutes_to_angle(tw->nautical_twilight_begin);
+    int32_t naut_end = minutes_to_angle(tw->nautical_twilight_end);
+    graphics_context_set_fill_color(ctx, COLOR_NAUTICAL_TWILIGHT);
+    graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, naut_begin, TRIG_MAX_ANGLE);
+    graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, 0, naut_end);
+  }
   
   // Civil twilight
-  int32_t civil_begin = minutes_to_angle(s_twilight.civil_twilight_begin);
-  int32_t civil_end = minutes_to_angle(s_twilight.civil_twilight_end);
-  graphics_context_set_fill_color(ctx, COLOR_CIVIL_TWILIGHT);
-  graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, civil_begin, TRIG_MAX_ANGLE);
-  graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, 0, civil_end);
+  if (tw->civil_twilight_begin >= 0) {
+    int32_t civil_begin = minutes_to_angle(tw->civil_twilight_begin);
+    int32_t civil_end = minutes_to_angle(tw->civil_twilight_end);
+    graphics_context_set_fill_color(ctx, COLOR_CIVIL_TWILIGHT);
+    graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, civil_begin, TRIG_MAX_ANGLE);
+    graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, 0, civil_end);
+  }
   
   // Day
-  int32_t sunrise = minutes_to_angle(s_twilight.sunrise);
-  int32_t sunset = minutes_to_angle(s_twilight.sunset);
-  graphics_context_set_fill_color(ctx, COLOR_DAY);
-  graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, sunrise, TRIG_MAX_ANGLE);
-  graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, 0, sunset);
+  if (tw->sunrise >= 0) {
+    int32_t sunrise = minutes_to_angle(tw->sunrise);
+    int32_t sunset = minutes_to_angle(tw->sunset);
+    graphics_context_set_fill_color(ctx, COLOR_DAY);
+    graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, sunrise, TRIG_MAX_ANGLE);
+    graphics_fill_radial(ctx, box, GOvalScaleModeFitCircle, TWILIGHT_RING_WIDTH, 0, sunset);
+  }
 }
 
 // Draw hour marks
@@ -458,11 +685,71 @@ static void draw_hand(GContext *ctx, int32_t angle, int16_t inner_radius, int16_
   graphics_draw_line(ctx, start, end);
 }
 
+// Milliseconds wall clock used to time benchmark frames
+static uint32_t bench_now_ms() {
+  time_t seconds;
+  uint16_t millis;
+  time_ms(&seconds, &millis);
+  return (uint32_t)seconds * 1000 + millis;
+}
+
+// Record the render time of one benchmark frame
+static void bench_record_frame(uint32_t elapsed_ms) {
+  s_bench.frame_pending = false;
+
+  if (s_bench.rendered == 0 || elapsed_ms < s_bench.min_ms) s_bench.min_ms = elapsed_ms;
+  if (elapsed_ms > s_bench.max_ms) s_bench.max_ms = elapsed_ms;
+  s_bench.total_ms += elapsed_ms;
+  s_bench.rendered++;
+
+  // A frame that overruns its slot delays the next one
+  if (elapsed_ms > BENCH_FRAME_INTERVAL_MS) s_bench.dropped++;
+}
+
+// Copy the canvas between the frame buffer and the cache (allocated on first use)
+static bool canvas_cache_copy(GContext *ctx, bool restore) {
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) return false;
+
+  if (!s_canvas_cache) {
+    s_canvas_cache = gbitmap_create_blank(s_bounds.size, gbitmap_get_format(frame_buffer));
+  }
+
+  if (s_canvas_cache) {
+    GBitmap *src = restore ? s_canvas_cache : frame_buffer;
+    GBitmap *dst = restore ? frame_buffer : s_canvas_cache;
+
+    for (int16_t y = 0; y < s_bounds.size.h; y++) {
+#ifdef PBL_ROUND
+      // Round displays store a different span of pixels on each row
+      GBitmapDataRowInfo src_row = gbitmap_get_data_row_info(src, y);
+      GBitmapDataRowInfo dst_row = gbitmap_get_data_row_info(dst, y);
+      memcpy(dst_row.data + src_row.min_x, src_row.data + src_row.min_x,
+             src_row.max_x - src_row.min_x + 1);
+#else
+      uint16_t src_stride = gbitmap_get_bytes_per_row(src);
+      uint16_t dst_stride = gbitmap_get_bytes_per_row(dst);
+      uint16_t row_bytes = (src_stride < dst_stride) ? src_stride : dst_stride;
+      memcpy(gbitmap_get_data(dst) + y * dst_stride, gbitmap_get_data(src) + y * src_stride, row_bytes);
+#endif
+    }
+  }
+
+  graphics_release_frame_buffer(ctx, frame_buffer);
+  return s_canvas_cache != NULL;
+}
+
 // Canvas layer update procedure
 static void canvas_update_proc(Layer *layer, GContext *ctx) {
+  // Seconds-only frame: replay the last full render instead of redrawing the rings
+  if (s_seconds_active && s_canvas_cache_valid && canvas_cache_copy(ctx, true)) {
+    return;
+  }
+
+  uint32_t frame_start_ms = bench_now_ms();
+
   // Get current time
-  time_t now = time(NULL);
-  struct tm *t = localtime(&now);
+  struct tm *t = get_display_time();
   
   // Clear background
   graphics_context_set_fill_color(ctx, COLOR_BACKGROUND);
@@ -593,23 +880,122 @@ static void canvas_update_proc(Layer *layer, GContext *ctx) {
   // Draw center dot
   // graphics_context_set_fill_color(ctx, COLOR_MINUTE_HAND); // Use minute hand color for dot
   // graphics_fill_circle(ctx, s_center, 2);
+
+  if (s_bench.frame_pending) {
+    bench_record_frame(bench_now_ms() - frame_start_ms);
+  }
+
+  // Keep this render for the seconds ticks until something else changes
+  if (s_seconds_active) {
+    s_canvas_cache_valid = canvas_cache_copy(ctx, false);
+  }
 }
 
-// Time tick handler
-static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
-  // Update date if day changed
-  if (units_changed & DAY_UNIT) {
-    update_date_display();
+// Days since 1970-01-01 for a calendar date (the table's day numbering)
+static int32_t days_from_civil(int year, int month, int mday) {
+  year -= month <= 2;
+  int era = year / 400;
+  int year_of_era = year - era * 400;
+  int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + mday - 1;
+  int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  return era * 146097 + day_of_era - 719468;
+}
+
+// Load one day's record for the saved location; false if the table doesn't cover it
+static bool load_twilight_from_table(time_t day, TwilightData *out) {
+  if (s_table_location < 0) return false;
+
+  ResHandle handle = resource_get_handle(RESOURCE_ID_TWILIGHT_TABLE);
+  uint8_t header[TABLE_HEADER_SIZE];
+  if (resource_load_byte_range(handle, 0, header, TABLE_HEADER_SIZE) != TABLE_HEADER_SIZE ||
+      memcmp(header, "SDTW", 4) != 0 || header[4] != TABLE_VERSION) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Twilight table missing or wrong version");
+    return false;
   }
-  
-  // Redraw
-  if (s_canvas_layer) {
-    layer_mark_dirty(s_canvas_layer);
+
+  int locations = header[5];
+  int32_t start = header[6] | (header[7] << 8);
+  int days = header[8] | (header[9] << 8);
+  if (s_table_location >= locations) {
+    return false;
+  }
+
+  struct tm *t = localtime(&day);
+  int32_t index = days_from_civil(t->tm_year + 1900, t->tm_mon + 1, t->tm_mday) - start;
+  if (index >= days) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Twilight table expired %d days ago: run npm run generate-twilight and rebuild",
+            (int)(index - days + 1));
+    return false;
   }
+  if (index < 0) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Twilight table starts in %d days", (int)-index);
+    return false;
+  }
+
+  // Only today's 16 bytes are read, never the whole table
+  int16_t record[TABLE_RECORD_SIZE / sizeof(int16_t)];
+  uint32_t offset = TABLE_HEADER_SIZE + ((uint32_t)s_table_location * days + index) * TABLE_RECORD_SIZE;
+  if (resource_load_byte_range(handle, offset, (uint8_t *)record, TABLE_RECORD_SIZE) != TABLE_RECORD_SIZE) {
+    return false;
+  }
+
+  out->astronomical_twilight_begin = record[0];
+  out->nautical_twilight_begin = record[1];
+  out->civil_twilight_begin = record[2];
+  out->sunrise = record[3];
+  out->sunset = record[4];
+  out->civil_twilight_end = record[5];
+  out->nautical_twilight_end = record[6];
+  out->astronomical_twilight_end = record[7];
+  out->valid = true;
+  return true;
+}
+
+// Same twilight times (field by field: the struct has padding)
+static bool twilight_equal(const TwilightData *a, const TwilightData *b) {
+  return a->valid == b->valid &&
+         a->astronomical_twilight_begin == b->astronomical_twilight_begin &&
+         a->nautical_twilight_begin == b->nautical_twilight_begin &&
+         a->civil_twilight_begin == b->civil_twilight_begin &&
+         a->sunrise == b->sunrise &&
+         a->sunset == b->sunset &&
+         a->civil_twilight_end == b->civil_twilight_end &&
+         a->nautical_twilight_end == b->nautical_twilight_end &&
+         a->astronomical_twilight_end == b->astronomical_twilight_end;
+}
+
+// Take new twilight data if it differs; returns whether anything changed
+static bool apply_twilight(const TwilightData *candidate, bool persist) {
+  if (twilight_equal(candidate, &s_twilight)) {
+    if (persist && s_twilight_unsaved) {
+      persist_write_data(STORAGE_KEY_TWILIGHT, &s_twilight, sizeof(TwilightData));
+      s_twilight_unsaved = false;
+    }
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Twilight data unchanged");
+    return false;
+  }
+
+  s_twilight = *candidate;
+  if (persist) {
+    persist_write_data(STORAGE_KEY_TWILIGHT, &s_twilight, sizeof(TwilightData));
+  }
+  s_twilight_unsaved = !persist;
+
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Twilight data updated: sunrise=%d, sunset=%d",
+          s_twilight.sunrise, s_twilight.sunset);
+  mark_canvas_dirty();
+  return true;
+}
+
+// Switch between the saved-location table and phone data
+static void set_table_location(int location) {
+  if (location == s_table_location) return;
+  s_table_location = location;
+  persist_write_int(STORAGE_KEY_TABLE_LOCATION, s_table_location);
 }
 
 // Send timezone to JS
-static void send_timezone_to_js() {
+static bool send_timezone_to_js() {
   char timezone_name[TIMEZONE_NAME_LENGTH];
   clock_get_timezone(timezone_name, TIMEZONE_NAME_LENGTH);
   
@@ -622,97 +1008,558 @@ static void send_timezone_to_js() {
     
     // Also send step goal request/confirm if valid?
     // Actually the JS handles logic.
-    app_message_outbox_send();
+    result = app_message_outbox_send();
   } else {
     APP_LOG(APP_LOG_LEVEL_ERROR, "Error preparing outbox: %d", (int)result);
   }
+  return result == APP_MSG_OK;
 }
 
-// AppMessage handlers
-static void inbox_received_handler(DictionaryIterator *iter, void *context) {
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "Message received from phone");
+// Whether the twilight data needs refreshing: new day, new timezone or old location
+static bool twilight_is_stale(time_t now) {
+  if (!s_twilight.valid) return true;
 
-  // Check if JS is ready
-  Tuple *js_ready_tuple = dict_find(iter, MESSAGE_KEY_js_ready);
-  if (js_ready_tuple) {
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "JS is ready, sending timezone");
-    send_timezone_to_js();
-    return;
+  // On the table every day is covered; the phone is only asked whether we moved
+  bool on_table = s_table_location >= 0;
+  if (!on_table && s_twilight_stamp.received < time_start_of_today()) return true;
+  if (now - s_twilight_stamp.received >= (on_table ? REFRESH_TABLE_MAX_AGE_S : REFRESH_MAX_AGE_S)) return true;
+
+  char timezone_name[TIMEZONE_NAME_LENGTH];
+  clock_get_timezone(timezone_name, TIMEZONE_NAME_LENGTH);
+  return strncmp(timezone_name, s_twilight_stamp.timezone, TIMEZONE_NAME_LENGTH) != 0;
+}
+
+// Failed or timed out request: wait exponentially longer before the next one
+static void refresh_backoff(time_t now) {
+  s_refresh.request_sent = 0;
+  s_refresh.backoff_s = s_refresh.backoff_s ? s_refresh.backoff_s * 2 : REFRESH_BACKOFF_MIN_S;
+  if (s_refresh.backoff_s > REFRESH_BACKOFF_MAX_S) s_refresh.backoff_s = REFRESH_BACKOFF_MAX_S;
+  s_refresh.next_attempt = now + s_refresh.backoff_s;
+
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Refresh failed, next attempt in %ds", (int)s_refresh.backoff_s);
+}
+
+// Fresh twilight data arrived: stamp it and clear the backoff
+static void refresh_complete(bool data_changed) {
+  char timezone_name[TIMEZONE_NAME_LENGTH];
+  clock_get_timezone(timezone_name, TIMEZONE_NAME_LENGTH);
+
+  // Only write flash when the stamp says something new: data, day or timezone,
+  // or when the saved copy is old enough to make the next launch think it's stale
+  time_t now = time(NULL);
+  bool persist = data_changed ||
+                 s_twilight_stamp.received < time_start_of_today() ||
+                 now - s_twilight_stamp_saved >= REFRESH_MAX_AGE_S / 2 ||
+                 strncmp(timezone_name, s_twilight_stamp.timezone, TIMEZONE_NAME_LENGTH) != 0;
+
+  s_twilight_stamp.received = now;
+  memcpy(s_twilight_stamp.timezone, timezone_name, TIMEZONE_NAME_LENGTH);
+  if (persist) {
+    persist_write_data(STORAGE_KEY_TWILIGHT_STAMP, &s_twilight_stamp, sizeof(TwilightStamp));
+    s_twilight_stamp_saved = now;
   }
-  
-  // Read date configuration
-  Tuple *date_format_tuple = dict_find(iter, MESSAGE_KEY_date_format_us);
-  Tuple *show_day_tuple = dict_find(iter, MESSAGE_KEY_show_day_of_week);
-  
-  bool config_changed = false;
-  if (date_format_tuple) {
-    s_date_config.date_format_us = date_format_tuple->value->int32 == 1;
-    config_changed = true;
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "Date format US: %d", s_date_config.date_format_us);
+
+  s_refresh.request_sent = 0;
+  s_refresh.next_attempt = 0;
+  s_refresh.backoff_s = 0;
+}
+
+// Ask the phone for data only when it is stale and the phone can answer.
+// Runs on wake-ups we already have (minute tick, js_ready), never on its own timer.
+static void refresh_poll() {
+  time_t now = time(NULL);
+
+  // Request in flight: wait for the reply, or count a timeout as a failure
+  if (s_refresh.request_sent) {
+    if (now - s_refresh.request_sent < REFRESH_TIMEOUT_S) return;
+    refresh_backoff(now);
   }
-  
-  if (show_day_tuple) {
-    s_date_config.show_day_of_week = show_day_tuple->value->int32 == 1;
-    config_changed = true;
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "Show day of week: %d", s_date_config.show_day_of_week);
+
+  if (!s_refresh.connected || !s_refresh.js_ready) return;
+  if (now < s_refresh.next_attempt) return;
+  if (!twilight_is_stale(now)) return;
+
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Twilight data stale, requesting refresh");
+  if (send_timezone_to_js()) {
+    s_refresh.request_sent = now;
+  } else {
+    refresh_backoff(now);
+  }
+}
+
+// Phone connection changes
+static void app_connection_handler(bool connected) {
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Phone %s", connected ? "connected" : "disconnected");
+  s_refresh.connected = connected;
+
+  if (connected) {
+    // Failures while away say nothing about the phone now; retry on the next tick
+    s_refresh.next_attempt = 0;
+    s_refresh.backoff_s = 0;
+  } else {
+    s_refresh.request_sent = 0;
+  }
+}
+
+// Seconds marker position: travels the outer twilight ring once a minute
+static GRect seconds_marker_frame(int seconds) {
+  int32_t angle = (seconds * TRIG_MAX_ANGLE) / 60;
+  int16_t dist = s_radius - TWILIGHT_RING_WIDTH / 2;
+  GPoint pos = {
+    .x = s_center.x + (sin_lookup(angle) * dist / TRIG_MAX_RATIO),
+    .y = s_center.y + (-cos_lookup(angle) * dist / TRIG_MAX_RATIO)
+  };
+  return GRect(pos.x - SECONDS_MARKER_SIZE / 2, pos.y - SECONDS_MARKER_SIZE / 2,
+               SECONDS_MARKER_SIZE, SECONDS_MARKER_SIZE);
+}
+
+// Seconds marker: a dot with a dark outline so it shows on every ring color
+static void seconds_update_proc(Layer *layer, GContext *ctx) {
+  GRect bounds = layer_get_bounds(layer);
+  GPoint center = grect_center_point(&bounds);
+
+  graphics_context_set_fill_color(ctx, GColorBlack);
+  graphics_fill_circle(ctx, center, SECONDS_MARKER_SIZE / 2);
+  graphics_context_set_fill_color(ctx, COLOR_SECONDS);
+  graphics_fill_circle(ctx, center, SECONDS_MARKER_SIZE / 2 - 1);
+}
+
+// Move the marker; only its old and new positions need drawing
+static void seconds_marker_move(int seconds) {
+  layer_set_frame(s_seconds_layer, seconds_marker_frame(seconds));
+  layer_mark_dirty(s_seconds_layer);
+}
+
+static void tick_handler(struct tm *tick_time, TimeUnits units_changed);
+
+// Switch seconds on or off from the setting, focus and battery
+static void seconds_mode_update() {
+  if (!s_seconds_layer) return;
+
+  BatteryChargeState battery = get_display_battery();
+  bool active = s_show_seconds && s_has_focus &&
+                (battery.is_charging || battery.charge_percent > SECONDS_MIN_BATTERY);
+  if (active == s_seconds_active) return;
+  s_seconds_active = active;
+
+  if (active) {
+    s_seconds_stats.started = time(NULL);
+    s_seconds_stats.battery_at_start = battery.charge_percent;
+    s_seconds_stats.ticks = 0;
+
+    time_t now = time(NULL);
+    seconds_marker_move(localtime(&now)->tm_sec);
+  } else {
+    // Battery spent while seconds were on, to check against the budget
+    int minutes = (time(NULL) - s_seconds_stats.started) / SECONDS_PER_MINUTE;
+    APP_LOG(APP_LOG_LEVEL_INFO, "Seconds mode off after %d min (%d ticks): battery %d%% -> %d%%",
+            minutes, (int)s_seconds_stats.ticks, s_seconds_stats.battery_at_start, battery.charge_percent);
+
+    if (s_canvas_cache) {
+      gbitmap_destroy(s_canvas_cache);
+      s_canvas_cache = NULL;
+    }
+    s_canvas_cache_valid = false;
   }
+
+  layer_set_hidden(s_seconds_layer, !active);
+  tick_timer_service_subscribe((active ? SECOND_UNIT : MINUTE_UNIT) | DAY_UNIT, tick_handler);
+}
+
+// Focus changes (notifications, other apps on top)
+static void app_focus_handler(bool in_focus) {
+  s_has_focus = in_focus;
+  seconds_mode_update();
+}
+
+// Time tick handler
+static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+  if (s_seconds_active) {
+    seconds_marker_move(tick_time->tm_sec);
+    s_seconds_stats.ticks++;
+
+    // Seconds-only tick: the rest of the face is unchanged
+    if (!(units_changed & MINUTE_UNIT)) return;
+  }
+
+  // Update date if day changed
+  if (units_changed & DAY_UNIT) {
+    update_date_display();
+
+    // Saved location: the new day comes from the table, no phone needed
+    TwilightData candidate;
+    if (s_table_location >= 0) {
+      if (load_twilight_from_table(time(NULL), &candidate)) {
+        apply_twilight(&candidate, false);
+      } else {
+        set_table_location(-1);
+      }
+    }
+  }
+
+  // Midnight, timezone changes and reconnects are all picked up here
+  refresh_poll();
+
+  // Steps and battery stay live if the worker goes away
+  check_worker();
+
+  // Battery may have crossed the seconds threshold
+  seconds_mode_update();
   
-  // Read step goal
-  Tuple *step_goal_tuple = dict_find(iter, MESSAGE_KEY_step_goal);
-  if (step_goal_tuple) {
-    s_step_goal = (int)step_goal_tuple->value->int32;
+  // Redraw
+  mark_canvas_dirty();
+}
+
+// Synthesize a plausible twilight table for a day of the year
+static void bench_synthesize_twilight(int yday) {
+  // Day length swings +-3h around 12h, longest at the June solstice (day 172)
+  int32_t angle = ((yday - 172) * TRIG_MAX_ANGLE) / 365;
+  int half_day = 360 + (180 * cos_lookup(angle)) / TRIG_MAX_RATIO;
+
+  TwilightData *tw = &s_bench.sim_twilight;
+  tw->sunrise = 720 - half_day;
+  tw->sunset = 720 + half_day;
+  tw->civil_twilight_begin = tw->sunrise - 30;
+  tw->civil_twilight_end = tw->sunset + 30;
+  tw->nautical_twilight_begin = tw->sunrise - 65;
+  tw->nautical_twilight_end = tw->sunset + 65;
+  tw->astronomical_twilight_begin = tw->sunrise - 100;
+  tw->astronomical_twilight_end = tw->sunset + 100;
+  tw->valid = true;
+}
+
+// Advance the simulated clock, battery and steps to the current frame
+static void bench_apply_frame() {
+  uint16_t frame = s_bench.frame;
+  uint16_t total = s_bench.total_frames;
+
+  if (s_bench.mode == BENCH_YEAR) {
+    s_bench.sim_time += SECONDS_PER_DAY + BENCH_YEAR_DRIFT_MINUTES * SECONDS_PER_MINUTE;
+    bench_synthesize_twilight(localtime(&s_bench.sim_time)->tm_yday);
+    update_date_display();
+  } else {
+    s_bench.sim_time += BENCH_DAY_STEP_MINUTES * SECONDS_PER_MINUTE;
+  }
+
+  // Drain the battery over the run, charging for one frame in eight
+  s_bench.sim_battery = 100 - (frame * 100) / total;
+  s_bench.sim_charging = (frame % 8) == 0;
+
+  // Walk the steps up to 120% of the goal so the full-ring path is exercised
+  s_bench.sim_steps = (int)((int32_t)frame * s_step_goal * 6 / 5 / total);
+}
+
+// Report benchmark results to the phone console
+static void bench_send_report(BenchMode mode, uint32_t mean_ms) {
+  DictionaryIterator *out_iter;
+  AppMessageResult result = app_message_outbox_begin(&out_iter);
+  if (result == APP_MSG_OK) {
+    dict_write_int32(out_iter, MESSAGE_KEY_benchmark_year, mode == BENCH_YEAR);
+    dict_write_int32(out_iter, MESSAGE_KEY_bench_frames, s_bench.rendered);
+    dict_write_int32(out_iter, MESSAGE_KEY_bench_dropped, s_bench.dropped);
+    dict_write_int32(out_iter, MESSAGE_KEY_bench_min_ms, (int32_t)s_bench.min_ms);
+    dict_write_int32(out_iter, MESSAGE_KEY_bench_mean_ms, (int32_t)mean_ms);
+    dict_write_int32(out_iter, MESSAGE_KEY_bench_max_ms, (int32_t)s_bench.max_ms);
+    app_message_outbox_send();
+  } else {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Error preparing benchmark report: %d", (int)result);
+  }
+}
+
+// Stop the replay, report, and return to the real clock
+static void bench_finish() {
+  if (s_bench.timer) {
+    app_timer_cancel(s_bench.timer);
+    s_bench.timer = NULL;
+  }
+
+  // The last frame never got a chance to render
+  if (s_bench.frame_pending) {
+    s_bench.dropped++;
+    s_bench.frame_pending = false;
+  }
+
+  BenchMode mode = s_bench.mode;
+  uint32_t mean_ms = s_bench.rendered ? s_bench.total_ms / s_bench.rendered : 0;
+  s_bench.mode = BENCH_OFF;
+
+  APP_LOG(APP_LOG_LEVEL_INFO, "Benchmark done: frames=%d dropped=%d min=%dms mean=%dms max=%dms",
+          s_bench.rendered, s_bench.dropped, (int)s_bench.min_ms, (int)mean_ms, (int)s_bench.max_ms);
+  bench_send_report(mode, mean_ms);
+
+  update_date_display();
+  mark_canvas_dirty();
+}
+
+// Fixed frame rate driver
+static void bench_timer_callback(void *data) {
+  s_bench.timer = NULL;
+
+  if (s_bench.frame >= s_bench.total_frames) {
+    bench_finish();
+    return;
+  }
+
+  // Re-arm first so render time doesn't stretch the frame interval
+  s_bench.timer = app_timer_register(BENCH_FRAME_INTERVAL_MS, bench_timer_callback, NULL);
+
+  // Previous frame still waiting to be drawn: it is superseded by this one
+  if (s_bench.frame_pending) {
+    s_bench.dropped++;
+  }
+
+  bench_apply_frame();
+  s_bench.frame++;
+  s_bench.frame_pending = true;
+
+  mark_canvas_dirty();
+}
+
+// Start a time-lapse replay from today's midnight
+static void bench_start(BenchMode mode) {
+  if (s_bench.mode != BENCH_OFF) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Benchmark already running");
+    return;
+  }
+
+  memset(&s_bench, 0, sizeof(BenchState));
+  s_bench.mode = mode;
+  s_bench.sim_time = time_start_of_today();
+  s_bench.total_frames = (mode == BENCH_YEAR) ? BENCH_YEAR_DAYS : 1440 / BENCH_DAY_STEP_MINUTES;
+  s_bench.sim_battery = 100;
+  s_bench.sim_twilight = s_twilight;
+
+  APP_LOG(APP_LOG_LEVEL_INFO, "Benchmark started: %s replay, %d frames at %dms",
+          (mode == BENCH_YEAR) ? "year" : "day", s_bench.total_frames, BENCH_FRAME_INTERVAL_MS);
+
+  s_bench.timer = app_timer_register(BENCH_FRAME_INTERVAL_MS, bench_timer_callback, NULL);
+}
+
+// Result of parsing one group of tuples from a message
+typedef enum {
+  PAYLOAD_ABSENT,     // None of the group's keys present
+  PAYLOAD_INVALID,    // Partial, wrong type or out of range: ignored
+  PAYLOAD_OK
+} PayloadStatus;
+
+#define STEP_GOAL_MAX 20000     // Settings slider maximum; the worker message carries it as uint16
+
+// Settings as they would be after applying a message
+typedef struct {
+  DateConfig date_config;
+  int step_goal;
+  bool show_hour_numbers;
+  bool show_seconds;
+} ConfigCandidate;
+
+// Read an integer tuple of any width; false if it isn't an integer
+static bool tuple_int(const Tuple *tuple, int32_t *out) {
+  bool is_signed = tuple->type == TUPLE_INT;
+  if (!is_signed && tuple->type != TUPLE_UINT) return false;
+
+  switch (tuple->length) {
+    case 1: *out = is_signed ? tuple->value->int8 : tuple->value->uint8; return true;
+    case 2: *out = is_signed ? tuple->value->int16 : tuple->value->uint16; return true;
+    case 4: *out = tuple->value->int32; return true;
+    default: return false;
+  }
+}
+
+// Read a 0/1 toggle tuple into *out
+static bool tuple_bool(const Tuple *tuple, bool *out) {
+  int32_t value;
+  if (!tuple_int(tuple, &value) || (value != 0 && value != 1)) return false;
+  *out = value == 1;
+  return true;
+}
+
+// Parse settings on top of the current values
+static PayloadStatus parse_config(DictionaryIterator *iter, ConfigCandidate *out) {
+  out->date_config = s_date_config;
+  out->step_goal = s_step_goal;
+  out->show_hour_numbers = s_show_hour_numbers;
+  out->show_seconds = s_show_seconds;
+
+  bool found = false;
+  Tuple *tuple;
+
+  if ((tuple = dict_find(iter, MESSAGE_KEY_date_format_us))) {
+    if (!tuple_bool(tuple, &out->date_config.date_format_us)) return PAYLOAD_INVALID;
+    found = true;
+  }
+  if ((tuple = dict_find(iter, MESSAGE_KEY_show_day_of_week))) {
+    if (!tuple_bool(tuple, &out->date_config.show_day_of_week)) return PAYLOAD_INVALID;
+    found = true;
+  }
+  if ((tuple = dict_find(iter, MESSAGE_KEY_step_goal))) {
+    int32_t goal;
+    if (!tuple_int(tuple, &goal) || goal < 0 || goal > STEP_GOAL_MAX) return PAYLOAD_INVALID;
+    out->step_goal = (int)goal;
+    found = true;
+  }
+  if ((tuple = dict_find(iter, MESSAGE_KEY_show_hour_numbers))) {
+    if (!tuple_bool(tuple, &out->show_hour_numbers)) return PAYLOAD_INVALID;
+    found = true;
+  }
+  if ((tuple = dict_find(iter, MESSAGE_KEY_show_seconds))) {
+    if (!tuple_bool(tuple, &out->show_seconds)) return PAYLOAD_INVALID;
+    found = true;
+  }
+
+  return found ? PAYLOAD_OK : PAYLOAD_ABSENT;
+}
+
+// Apply only the settings that changed, redrawing only what shows them
+static void apply_config(const ConfigCandidate *config) {
+  if (config->date_config.date_format_us != s_date_config.date_format_us ||
+      config->date_config.show_day_of_week != s_date_config.show_day_of_week) {
+    s_date_config = config->date_config;
+    persist_write_data(STORAGE_KEY_DATE_CONFIG, &s_date_config, sizeof(DateConfig));
+    update_date_display();
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Date config: US=%d, ShowDay=%d",
+            s_date_config.date_format_us, s_date_config.show_day_of_week);
+  }
+
+  if (config->step_goal != s_step_goal) {
+    s_step_goal = config->step_goal;
     persist_write_int(STORAGE_KEY_STEP_GOAL, s_step_goal);
-    get_step_count(); // Update steps with new goal (enable/disable check)
-    if (s_canvas_layer) layer_mark_dirty(s_canvas_layer);
+    if (s_worker_active) {
+      send_step_goal_to_worker();
+    } else {
+      get_step_count(); // Update steps with new goal (enable/disable check)
+    }
+    mark_canvas_dirty();
     APP_LOG(APP_LOG_LEVEL_DEBUG, "Step goal updated: %d", s_step_goal);
   }
 
-  // Read show hour numbers
-  Tuple *hour_numbers_tuple = dict_find(iter, MESSAGE_KEY_show_hour_numbers);
-  if (hour_numbers_tuple) {
-    s_show_hour_numbers = (hour_numbers_tuple->value->int32 == 1);
+  if (config->show_hour_numbers != s_show_hour_numbers) {
+    s_show_hour_numbers = config->show_hour_numbers;
     persist_write_bool(STORAGE_KEY_SHOW_HOUR_NUMBERS, s_show_hour_numbers);
-    if (s_canvas_layer) layer_mark_dirty(s_canvas_layer);
+    mark_canvas_dirty();
     APP_LOG(APP_LOG_LEVEL_DEBUG, "Show Hour Numbers: %d", s_show_hour_numbers);
   }
-  
-  if (config_changed) {
-    persist_write_data(STORAGE_KEY_DATE_CONFIG, &s_date_config, sizeof(DateConfig));
-    update_date_display();
+
+  if (config->show_seconds != s_show_seconds) {
+    s_show_seconds = config->show_seconds;
+    persist_write_bool(STORAGE_KEY_SHOW_SECONDS, s_show_seconds);
+    seconds_mode_update();
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Show seconds: %d", s_show_seconds);
+  }
+
+  // Saving settings is a deliberate moment to offer the worker again
+  persist_delete(STORAGE_KEY_WORKER_DECLINED);
+  if (!s_worker_active && start_worker()) {
+    health_service_events_unsubscribe();
+    s_worker_active = true;
+  }
+}
+
+// Parse the eight twilight times (minutes since midnight)
+static PayloadStatus parse_twilight(DictionaryIterator *iter, TwilightData *out) {
+  // Same order as the TwilightData fields below
+  const uint32_t keys[] = {
+    MESSAGE_KEY_astronomical_twilight_begin,
+    MESSAGE_KEY_nautical_twilight_begin,
+    MESSAGE_KEY_civil_twilight_begin,
+    MESSAGE_KEY_sunrise,
+    MESSAGE_KEY_sunset,
+    MESSAGE_KEY_civil_twilight_end,
+    MESSAGE_KEY_nautical_twilight_end,
+    MESSAGE_KEY_astronomical_twilight_end,
+  };
+  const int count = sizeof(keys) / sizeof(keys[0]);
+  int16_t values[sizeof(keys) / sizeof(keys[0])];
+  int found = 0;
+
+  for (int i = 0; i < count; i++) {
+    Tuple *tuple = dict_find(iter, keys[i]);
+    if (!tuple) continue;
+
+    int32_t minutes;
+    if (!tuple_int(tuple, &minutes) || minutes < 0 || minutes >= 1440) return PAYLOAD_INVALID;
+    values[i] = (int16_t)minutes;
+    found++;
+  }
+
+  if (found == 0) return PAYLOAD_ABSENT;
+  if (found < count) return PAYLOAD_INVALID;
+
+  out->astronomical_twilight_begin = values[0];
+  out->nautical_twilight_begin = values[1];
+  out->civil_twilight_begin = values[2];
+  out->sunrise = values[3];
+  out->sunset = values[4];
+  out->civil_twilight_end = values[5];
+  out->nautical_twilight_end = values[6];
+  out->astronomical_twilight_end = values[7];
+  out->valid = true;
+  return PAYLOAD_OK;
+}
+
+// AppMessage handlers
+static void inbox_received_handler(DictionaryIterator *iter, void *context) {
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Message received from phone");
+
+  // Check if JS is ready
+  Tuple *js_ready_tuple = dict_find(iter, MESSAGE_KEY_js_ready);
+  if (js_ready_tuple) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "JS is ready");
+    // A (re)started JS never saw earlier requests and resets any backoff
+    s_refresh.js_ready = true;
+    s_refresh.request_sent = 0;
+    s_refresh.next_attempt = 0;
+    s_refresh.backoff_s = 0;
+    refresh_poll();
+    return;
   }
   
-  // Read twilight data
-  Tuple *sunrise_tuple = dict_find(iter, MESSAGE_KEY_sunrise);
-  Tuple *sunset_tuple = dict_find(iter, MESSAGE_KEY_sunset);
-  Tuple *civil_begin_tuple = dict_find(iter, MESSAGE_KEY_civil_twilight_begin);
-  Tuple *civil_end_tuple = dict_find(iter, MESSAGE_KEY_civil_twilight_end);
-  Tuple *nautical_begin_tuple = dict_find(iter, MESSAGE_KEY_nautical_twilight_begin);
-  Tuple *nautical_end_tuple = dict_find(iter, MESSAGE_KEY_nautical_twilight_end);
-  Tuple *astro_begin_tuple = dict_find(iter, MESSAGE_KEY_astronomical_twilight_begin);
-  Tuple *astro_end_tuple = dict_find(iter, MESSAGE_KEY_astronomical_twilight_end);
-  
-  if (sunrise_tuple && sunset_tuple) {
-    s_twilight.sunrise = (int16_t)sunrise_tuple->value->int32;
-    s_twilight.sunset = (int16_t)sunset_tuple->value->int32;
-    s_twilight.civil_twilight_begin = (int16_t)civil_begin_tuple->value->int32;
-    s_twilight.civil_twilight_end = (int16_t)civil_end_tuple->value->int32;
-    s_twilight.nautical_twilight_begin = (int16_t)nautical_begin_tuple->value->int32;
-    s_twilight.nautical_twilight_end = (int16_t)nautical_end_tuple->value->int32;
-    s_twilight.astronomical_twilight_begin = (int16_t)astro_begin_tuple->value->int32;
-    s_twilight.astronomical_twilight_end = (int16_t)astro_end_tuple->value->int32;
-    s_twilight.valid = true;
-    
-    // Save to persistent storage
-    persist_write_data(STORAGE_KEY_TWILIGHT, &s_twilight, sizeof(TwilightData));
-    
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "Twilight data updated: sunrise=%d, sunset=%d", 
-            s_twilight.sunrise, s_twilight.sunset);
-    
-    // Redraw
-    if (s_canvas_layer) {
-      layer_mark_dirty(s_canvas_layer);
+  // Settings from Clay
+  ConfigCandidate config;
+  PayloadStatus config_status = parse_config(iter, &config);
+  if (config_status == PAYLOAD_OK) {
+    apply_config(&config);
+  } else if (config_status == PAYLOAD_INVALID) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Rejected settings: bad value");
+  }
+
+  // Developer benchmark: replay runs once per settings save while enabled
+  Tuple *bench_tuple = dict_find(iter, MESSAGE_KEY_benchmark_mode);
+  int32_t bench_value;
+  if (bench_tuple && tuple_int(bench_tuple, &bench_value) && bench_value == 1) {
+    Tuple *bench_year_tuple = dict_find(iter, MESSAGE_KEY_benchmark_year);
+    int32_t bench_year = 0;
+    if (bench_year_tuple) tuple_int(bench_year_tuple, &bench_year);
+    bench_start(bench_year == 1 ? BENCH_YEAR : BENCH_DAY);
+  }
+
+  // Phone says we're at a saved location (>= 0) or not (-1)
+  Tuple *table_tuple = dict_find(iter, MESSAGE_KEY_table_location);
+  int32_t table_location;
+  if (table_tuple) {
+    if (tuple_int(table_tuple, &table_location) && table_location >= -1 && table_location <= 255) {
+      set_table_location((int)table_location);
+      TwilightData candidate;
+      if (s_table_location >= 0) {
+        if (load_twilight_from_table(time(NULL), &candidate)) {
+          refresh_complete(apply_twilight(&candidate, false));
+        } else {
+          set_table_location(-1);
+        }
+      }
+    } else {
+      APP_LOG(APP_LOG_LEVEL_WARNING, "Rejected table location");
     }
   }
+
+  // Twilight data: all eight times or nothing
+  TwilightData twilight;
+  PayloadStatus twilight_status = parse_twilight(iter, &twilight);
+  if (twilight_status == PAYLOAD_OK) {
+    // Resent cache hits match what we have: no flash write, no redraw
+    refresh_complete(apply_twilight(&twilight, true));
+  } else if (twilight_status == PAYLOAD_INVALID) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Rejected twilight data: partial or out of range");
+  }
 }
 
 static void inbox_dropped_handler(AppMessageResult reason, void *context) {
@@ -721,6 +1568,10 @@ static void inbox_dropped_handler(AppMessageResult reason, void *context) {
 
 static void outbox_failed_handler(DictionaryIterator *iter, AppMessageResult reason, void *context) {
   APP_LOG(APP_LOG_LEVEL_ERROR, "Outbox send failed: %d", reason);
+
+  if (dict_find(iter, MESSAGE_KEY_timezone_string)) {
+    refresh_backoff(time(NULL));
+  }
 }
 
 static void outbox_sent_handler(DictionaryIterator *iter, void *context) {
@@ -749,6 +1600,12 @@ static void window_load(Window *window) {
   s_canvas_layer = layer_create(s_bounds);
   layer_set_update_proc(s_canvas_layer, canvas_update_proc);
   layer_add_child(window_layer, s_canvas_layer);
+
+  // Seconds marker: its own tiny layer, hidden until seconds mode is active
+  s_seconds_layer = layer_create(seconds_marker_frame(0));
+  layer_set_update_proc(s_seconds_layer, seconds_update_proc);
+  layer_set_hidden(s_seconds_layer, true);
+  layer_add_child(window_layer, s_seconds_layer);
   
   // Create date layer at 30% from bottom of circle
   // Position: center.y + (radius * 0.3)
@@ -773,6 +1630,8 @@ static void window_load(Window *window) {
 
 static void window_unload(Window *window) {
   text_layer_destroy(s_date_layer);
+  layer_destroy(s_seconds_layer);
+  s_seconds_layer = NULL;
   layer_destroy(s_canvas_layer);
   s_canvas_layer = NULL;
   s_date_layer = NULL;
@@ -808,6 +1667,22 @@ static void init(void) {
     APP_LOG(APP_LOG_LEVEL_DEBUG, "Loaded twilight data from storage");
     APP_LOG(APP_LOG_LEVEL_DEBUG, "Loaded twilight data from storage");
   }
+  if (persist_exists(STORAGE_KEY_TWILIGHT_STAMP)) {
+    persist_read_data(STORAGE_KEY_TWILIGHT_STAMP, &s_twilight_stamp, sizeof(TwilightStamp));
+    s_twilight_stamp_saved = s_twilight_stamp.received;
+  }
+
+  // Saved location: today's twilight comes straight from the table
+  if (persist_exists(STORAGE_KEY_TABLE_LOCATION)) {
+    s_table_location = persist_read_int(STORAGE_KEY_TABLE_LOCATION);
+    if (s_table_location >= 0) {
+      if (load_twilight_from_table(time(NULL), &s_twilight)) {
+        s_twilight_unsaved = true;
+      } else {
+        set_table_location(-1);
+      }
+    }
+  }
   
   // Load step goal
   if (persist_exists(STORAGE_KEY_STEP_GOAL)) {
@@ -815,18 +1690,21 @@ static void init(void) {
     APP_LOG(APP_LOG_LEVEL_DEBUG, "Loaded step goal: %d", s_step_goal);
   }
 
+  // Load show_seconds
+  if (persist_exists(STORAGE_KEY_SHOW_SECONDS)) {
+    s_show_seconds = persist_read_bool(STORAGE_KEY_SHOW_SECONDS);
+  }
+
   // Load show_hour_numbers
   if (persist_exists(STORAGE_KEY_SHOW_HOUR_NUMBERS)) {
     s_show_hour_numbers = persist_read_bool(STORAGE_KEY_SHOW_HOUR_NUMBERS);
     APP_LOG(APP_LOG_LEVEL_DEBUG, "Loaded show_hour_numbers: %d", s_show_hour_numbers);
   }
   
-  // Subscribe to health events
-  if (health_service_events_subscribe(health_handler, NULL)) {
-    // Force initial update
-    get_step_count();
-  } else {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Health not available!");
+  // Steps and battery come from the background worker; fall back to health events
+  s_worker_active = start_worker();
+  if (!s_worker_active) {
+    start_health_fallback();
   }
   
   // Register AppMessage handlers
@@ -837,6 +1715,12 @@ static void init(void) {
   
   // Open AppMessage
   app_message_open(256, 256);
+
+  // Track the phone connection for the refresh scheduler
+  s_refresh.connected = connection_service_peek_pebble_app_connection();
+  connection_service_subscribe((ConnectionHandlers) {
+    .pebble_app_connection_handler = app_connection_handler,
+  });
   
   // Create main window
   s_window = window_create();
@@ -849,15 +1733,33 @@ static void init(void) {
   
   // Subscribe to time tick service (minute and day updates)
   tick_timer_service_subscribe(MINUTE_UNIT | DAY_UNIT, tick_handler);
+
+  // Seconds mode switches the tick unit and pauses while out of focus
+  app_focus_service_subscribe_handlers((AppFocusHandlers) {
+    .did_focus = app_focus_handler,
+  });
+  seconds_mode_update();
   
   APP_LOG(APP_LOG_LEVEL_DEBUG, "Sundrive initialized");
 }
 
 // App deinitialization
 static void deinit(void) {
+  if (s_bench.timer) {
+    app_timer_cancel(s_bench.timer);
+  }
   tick_timer_service_unsubscribe();
-  health_service_events_unsubscribe();
+  app_focus_service_unsubscribe();
+  connection_service_unsubscribe();
+  if (s_worker_active) {
+    app_worker_message_unsubscribe();
+  } else {
+    health_service_events_unsubscribe();
+  }
   window_destroy(s_window);
+  if (s_canvas_cache) {
+    gbitmap_destroy(s_canvas_cache);
+  }
 }
 
 // Main entry point
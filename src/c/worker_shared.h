@@ -0,0 +1,24 @@
+#pragma once
+
+// Shared between the watchface (src/c) and the background worker (worker_src/c)
+
+// AppWorkerMessage types
+#define WORKER_MSG_STEPS 1        // Worker -> face: data0 = steps >> 16, data1 = steps & 0xFFFF
+#define WORKER_MSG_BATTERY 2      // Worker -> face: data0 = charge percent, data1 = charging
+#define WORKER_MSG_STEP_GOAL 3    // Face -> worker: data0 = goal (also asks for a full update)
+
+// Persistent storage keys read by both sides
+#define STORAGE_KEY_STEP_GOAL 3
+#define STORAGE_KEY_WORKER_AGGREGATES 10
+
+#define WORKER_HOURS 24
+
+// Health and battery aggregates kept up to date by the worker
+typedef struct {
+  time_t day_start;                       // time_start_of_today() these values belong to
+  uint32_t steps;                         // Step total for the day
+  uint16_t hourly_steps[WORKER_HOURS];    // Steps per hour of the day
+  uint8_t battery_history[WORKER_HOURS];  // Battery percent sampled at each hour
+  uint8_t battery_percent;
+  bool battery_charging;
+} WorkerAggregates;
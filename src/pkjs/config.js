@@ -27,6 +27,13 @@ module.exports = [
         "description": "Show 0, 6, 12, 18 instead of ticks",
         "defaultValue": false
       },
+      {
+        "type": "toggle",
+        "messageKey": "show_seconds",
+        "label": "Show Seconds",
+        "description": "A small dot travels the outer ring once a minute. Pauses below 20% battery and while a notification or app is on top",
+        "defaultValue": false
+      },
       {
         "type": "slider",
         "messageKey": "step_goal",
@@ -39,6 +46,29 @@ module.exports = [
       }
     ]
   },
+  {
+    "type": "section",
+    "items": [
+      {
+        "type": "heading",
+        "defaultValue": "Developer"
+      },
+      {
+        "type": "toggle",
+        "messageKey": "benchmark_mode",
+        "label": "Render Benchmark",
+        "description": "Replay a full day at 20 fps on every save and log frame times to the phone console",
+        "defaultValue": false
+      },
+      {
+        "type": "toggle",
+        "messageKey": "benchmark_year",
+        "label": "Replay a Year",
+        "description": "Replay a year of simulated twilight data instead of a single day",
+        "defaultValue": false
+      }
+    ]
+  },
   {
     "type": "submit",
     "defaultValue": "Save Settings"
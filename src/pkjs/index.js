@@ -1,7 +1,21 @@
 // Sundrive JavaScript component - handles API communication
-var Clay = require('@rebble/clay');
-var clayConfig = require('./config');
-var clay = new Clay(clayConfig);
+
+// Startup timing - marks are milliseconds since this script started
+var scriptStart = Date.now();
+var startupMarks = { script_start: 0 };
+var startupReported = false;
+
+// A watch with fresh data answers js_ready with silence; this long without a
+// timezone request means it needed nothing
+var WATCH_FRESH_WINDOW_MS = 5000;
+
+// Clay is built on first use (see getClay)
+var clay = null;
+
+// Saved locations with a year-ahead twilight table on the watch, and the
+// days that table covers (written by tools/generate_twilight_table.js)
+var savedLocations = require('./saved_locations.json');
+var twilightTable = require('./twilight_table.json');
 
 var testMode = false; // Set to true to use local test data
 
@@ -24,6 +38,55 @@ var exampleData = {
   "astronomical_twilight_end": "7:43:53 PM"
 }
 
+// Record a startup step, first occurrence only (atMs defaults to now)
+function markStartup(step, atMs) {
+  if (startupReported || startupMarks[step] !== undefined) return;
+  startupMarks[step] = (atMs !== undefined) ? atMs : Date.now() - scriptStart;
+}
+
+// Report the startup chain once the watch has its first real data (or gave up)
+function finishStartup(outcome) {
+  // Only the chain started by the watch's timezone request counts
+  if (startupReported || startupMarks.timezone_received === undefined) return;
+  reportStartup(outcome);
+}
+
+// Log the startup chain once, ending with its outcome (stamped at atMs if given)
+function reportStartup(outcome, atMs) {
+  markStartup(outcome, atMs);
+  startupReported = true;
+
+  var steps = [];
+  var previous = 0;
+  for (var step in startupMarks) {
+    steps.push({ step: step, at_ms: startupMarks[step], delta_ms: startupMarks[step] - previous });
+    previous = startupMarks[step];
+  }
+
+  console.log('Startup timing: ' + JSON.stringify({
+    outcome: outcome,
+    total_ms: previous,
+    steps: steps
+  }));
+}
+
+// Build Clay on first use - settings are opened rarely, so keep it off the startup path
+function getClay() {
+  if (!clay) {
+    var Clay = require('@rebble/clay');
+    var clayConfig = require('./config');
+    clay = new Clay(clayConfig, null, { autoHandleEvents: false });
+
+    // Clay fills its meta from its own 'ready' listener, which was registered
+    // after 'ready' fired. Without this the page sees activeWatchInfo: null and
+    // capability filters and color items silently misbehave.
+    clay.meta.activeWatchInfo = Pebble.getActiveWatchInfo && Pebble.getActiveWatchInfo();
+    clay.meta.accountToken = Pebble.getAccountToken();
+    clay.meta.watchToken = Pebble.getWatchToken();
+  }
+  return clay;
+}
+
 // Round coordinate to 2 decimal places
 function roundCoordinate(coord) {
   return Math.round(coord * 100) / 100;
@@ -107,6 +170,73 @@ function isCacheValid(cache, latitude, longitude, tzid) {
   return true;
 }
 
+// Today's record in the watch table, counted from its start date like the watch does
+function twilightTableIndex() {
+  var now = new Date();
+  var today = Date.UTC(now.getFullYear(), now.getMonth(), now.getDate());
+  var start = Date.parse(twilightTable.start);
+  return Math.round((today - start) / 86400000);
+}
+
+// Index of the saved location covering this position, or -1.
+// The watch table only covers its date range and the location's own timezone.
+function findSavedLocation(latitude, longitude, tzid) {
+  var day = twilightTableIndex();
+  if (day >= twilightTable.days) {
+    console.log('WARNING: saved location table expired on ' + twilightTable.last +
+                ' - run npm run generate-twilight and rebuild');
+    return -1;
+  }
+  if (day < 0) return -1;
+
+  for (var i = 0; i < savedLocations.locations.length; i++) {
+    var location = savedLocations.locations[i];
+    if (location.tzid === tzid &&
+        Math.abs(latitude - location.latitude) < savedLocations.radius_deg &&
+        Math.abs(longitude - location.longitude) < savedLocations.radius_deg) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Tell the watch to read twilight data from its table for a saved location
+function sendTableLocation(index) {
+  console.log('Inside saved location ' + savedLocations.locations[index].name + ', watch uses its table');
+
+  Pebble.sendAppMessage({ 'table_location': index },
+    function (e) {
+      console.log('Table location sent successfully');
+      finishStartup('table_sent');
+    },
+    function (e) {
+      console.log('Error sending table location: ' + e.error.message);
+      finishStartup('data_send_failed');
+    }
+  );
+}
+
+// Use the watch table at a saved location, else cached or fetched data
+function sendDataForPosition(latitude, longitude, tzid) {
+  var tableIndex = findSavedLocation(latitude, longitude, tzid);
+  if (tableIndex >= 0) {
+    markStartup('table_hit');
+    sendTableLocation(tableIndex);
+    return;
+  }
+
+  // Try to load and validate cache
+  var cache = loadCache();
+  if (isCacheValid(cache, latitude, longitude, tzid)) {
+    console.log('Using cached twilight data');
+    markStartup('cache_hit');
+    sendTwilightData(cache.data);
+  } else {
+    console.log('Cache invalid or expired, fetching from API');
+    fetchTwilightData(latitude, longitude, tzid);
+  }
+}
+
 // Convert time string from API format to minutes since midnight
 function timeStringToMinutes(timeStr) {
   // Format: "7:28:31 AM" or "4:51:53 PM"
@@ -129,9 +259,12 @@ function fetchTwilightData(latitude, longitude, tzid) {
 
   var url = 'https://api.sunrise-sunset.org/json?lat=' + latitude + '&lng=' + longitude + '&formatted=1&tzid=' + encodeURIComponent(tzid);
 
+  markStartup('xhr_start');
+
   var xhr = new XMLHttpRequest();
   xhr.open('GET', url, true);
   xhr.onload = function () {
+    markStartup('xhr_done');
     if (xhr.readyState === 4 && xhr.status === 200) {
       try {
         var response = JSON.parse(xhr.responseText);
@@ -141,16 +274,20 @@ function fetchTwilightData(latitude, longitude, tzid) {
           sendTwilightData(response.results);
         } else {
           console.log('API returned error status: ' + response.status);
+          finishStartup('api_error');
         }
       } catch (e) {
         console.log('Error parsing API response: ' + e);
+        finishStartup('api_error');
       }
     } else {
       console.log('API request failed: ' + xhr.status);
+      finishStartup('api_error');
     }
   };
   xhr.onerror = function () {
     console.log('Network error fetching twilight data');
+    finishStartup('network_error');
   };
   xhr.send();
 }
@@ -167,7 +304,8 @@ function sendTwilightData(results) {
     'nautical_twilight_begin': timeStringToMinutes(results.nautical_twilight_begin),
     'nautical_twilight_end': timeStringToMinutes(results.nautical_twilight_end),
     'astronomical_twilight_begin': timeStringToMinutes(results.astronomical_twilight_begin),
-    'astronomical_twilight_end': timeStringToMinutes(results.astronomical_twilight_end)
+    'astronomical_twilight_end': timeStringToMinutes(results.astronomical_twilight_end),
+    'table_location': -1 // Live data: leave the saved-location table
   };
 
   console.log('Data:', JSON.stringify(dict));
@@ -175,9 +313,11 @@ function sendTwilightData(results) {
   Pebble.sendAppMessage(dict,
     function (e) {
       console.log('Twilight data sent successfully');
+      finishStartup('data_sent');
     },
     function (e) {
       console.log('Error sending twilight data: ' + e.error.message);
+      finishStartup('data_send_failed');
     }
   );
 }
@@ -198,37 +338,22 @@ function updateTwilightData(tzid) {
   }
   console.log('Using timezone: ' + tzid);
 
+  markStartup('geolocation_start');
+
   navigator.geolocation.getCurrentPosition(
     function (pos) {
+      markStartup('geolocation_done');
       lastPosition = pos.coords;
-      var latitude = pos.coords.latitude;
-      var longitude = pos.coords.longitude;
-
-      // Try to load and validate cache
-      var cache = loadCache();
-      if (isCacheValid(cache, latitude, longitude, tzid)) {
-        console.log('Using cached twilight data');
-        sendTwilightData(cache.data);
-      } else {
-        console.log('Cache invalid or expired, fetching from API');
-        fetchTwilightData(latitude, longitude, tzid);
-      }
+      sendDataForPosition(pos.coords.latitude, pos.coords.longitude, tzid);
     },
     function (err) {
+      markStartup('geolocation_error');
       console.log('Location error: ' + err.message);
       // Fallback to default location (Zaragoza, Spain)
       var defaultLat = 41.65606;
       var defaultLng = -0.87734;
-
-      // Check cache for fallback location
-      var cache = loadCache();
-      if (isCacheValid(cache, defaultLat, defaultLng, tzid)) {
-        console.log('Using cached twilight data for fallback location');
-        sendTwilightData(cache.data);
-      } else {
-        console.log('Fetching from API for fallback location');
-        fetchTwilightData(defaultLat, defaultLng, tzid);
-      }
+      console.log('Using fallback location');
+      sendDataForPosition(defaultLat, defaultLng, tzid);
     },
     { timeout: 15000, maximumAge: 60000 }
   );
@@ -237,14 +362,23 @@ function updateTwilightData(tzid) {
 // Listen for when the watchface is opened
 Pebble.addEventListener('ready', function (e) {
   console.log('PebbleKit JS ready!');
+  markStartup('ready');
 
-  // Send initial data (not cached)
-  console.log('Sending initial example data');
-  sendTwilightData(exampleData);
-
-  // Notify watch that JS is ready to receive timezone
+  // Notify watch that JS is ready. The watch keeps its last data and
+  // sends its timezone only when that data is stale.
   Pebble.sendAppMessage({ 'js_ready': 1 },
-    function (e) { console.log('Ready message sent'); },
+    function (e) {
+      console.log('Ready message sent');
+      markStartup('js_ready_sent');
+
+      // Stale data makes the watch reply with its timezone right away.
+      // Startup ended at js_ready_sent; the wait below is not part of it.
+      setTimeout(function () {
+        if (!startupReported && startupMarks.timezone_received === undefined) {
+          reportStartup('watch_fresh', startupMarks.js_ready_sent);
+        }
+      }, WATCH_FRESH_WINDOW_MS);
+    },
     function (e) { console.log('Error sending ready message: ' + e.error.message); }
   );
 });
@@ -267,17 +401,42 @@ Pebble.addEventListener('appmessage', function (e) {
   if (e.payload.timezone_string) {
     var originalTz = e.payload.timezone_string;
     console.log('Received timezone from watch: ' + originalTz);
+    markStartup('timezone_received');
 
     var normalizedTz = normalizeTimezone(originalTz);
     updateTwilightData(normalizedTz);
+  } else if (e.payload.bench_frames !== undefined) {
+    // Render benchmark report from the watch
+    var report = {
+      mode: e.payload.benchmark_year ? 'year' : 'day',
+      frames: e.payload.bench_frames,
+      dropped: e.payload.bench_dropped,
+      min_ms: e.payload.bench_min_ms,
+      mean_ms: e.payload.bench_mean_ms,
+      max_ms: e.payload.bench_max_ms
+    };
+    console.log('Benchmark report: ' + JSON.stringify(report));
   } else {
-    // If no timezone in message (e.g. settings update), assume existing logic or request again?
-    // For now, if we get other messages, we might want to check what they are.
-    // If it's just a poke to update, we might need a stored timezone or request it again.
-    // But updateTwilightData handles missing tzid by defaulting to UTC.
-    // Let's assume generic updates might want to re-trigger the flow or use a stored TZ.
-    // For simplicity, if we get a generic update request without TZ, we might default to UTC or cached.
-    // Ideally the C side sends TZ when it wants an update.
+    // The watch schedules refreshes itself and always sends its timezone with them
     console.log('Received message without timezone');
   }
 });
+
+
+// Open the settings page
+Pebble.addEventListener('showConfiguration', function (e) {
+  Pebble.openURL(getClay().generateUrl());
+});
+
+// Forward saved settings to the watch
+Pebble.addEventListener('webviewclosed', function (e) {
+  if (!e || !e.response) {
+    return;
+  }
+
+  var dict = getClay().getSettings(e.response);
+  Pebble.sendAppMessage(dict,
+    function (e) { console.log('Settings sent successfully'); },
+    function (e) { console.log('Error sending settings: ' + e.error.message); }
+  );
+});
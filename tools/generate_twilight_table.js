@@ -0,0 +1,196 @@
+// Sundrive twilight table generator - precomputes a year of twilight times,
+// starting today or at the configured start date, for the saved locations in
+// src/pkjs/saved_locations.json. Packs them into resources/data/twilight_table.bin
+// for the watch and writes the covered range to src/pkjs/twilight_table.json.
+//
+// Usage: npm run generate-twilight
+//
+// Binary layout (little-endian):
+//   Header (12 bytes)
+//     char[4]  magic "SDTW"
+//     uint8    version (2)
+//     uint8    location count
+//     uint16   start day (days since 1970-01-01)
+//     uint16   day count (365 or 366, up to the same date next year)
+//     uint16   record size (16)
+//   Records, location-major: offset = 12 + (location * days + day) * 16
+//     int16[8] minutes since local midnight, in TwilightData field order:
+//              astronomical/nautical/civil begin, sunrise, sunset,
+//              civil/nautical/astronomical end
+//     A phase the sun never reaches is stored as -1 on both sides. A phase
+//     the sun never leaves is stored as 0/0, which draws as a full ring.
+var fs = require('fs');
+var path = require('path');
+
+var ROOT = path.join(__dirname, '..');
+var CONFIG_FILE = path.join(ROOT, 'src/pkjs/saved_locations.json');
+var OUTPUT_FILE = path.join(ROOT, 'resources/data/twilight_table.bin');
+var RANGE_FILE = path.join(ROOT, 'src/pkjs/twilight_table.json');
+
+var MAGIC = 'SDTW';
+var VERSION = 2;
+var DAY_MS = 86400000;
+var HEADER_SIZE = 12;
+var RECORD_SIZE = 16;
+
+// Sun zenith angles for sunrise/sunset and civil, nautical, astronomical twilight
+var ZENITH_SUNRISE = 90.833;
+var ZENITH_CIVIL = 96;
+var ZENITH_NAUTICAL = 102;
+var ZENITH_ASTRONOMICAL = 108;
+
+function toRad(deg) { return deg * Math.PI / 180; }
+function toDeg(rad) { return rad * 180 / Math.PI; }
+
+// Solar declination (deg) and equation of time (minutes) - NOAA algorithm
+function solarPosition(utcMs) {
+  var jd = utcMs / 86400000 + 2440587.5;
+  var t = (jd - 2451545) / 36525;
+
+  var l0 = (280.46646 + t * (36000.76983 + t * 0.0003032)) % 360;
+  var m = 357.52911 + t * (35999.05029 - 0.0001537 * t);
+  var e = 0.016708634 - t * (0.000042037 + 0.0000001267 * t);
+  var c = Math.sin(toRad(m)) * (1.914602 - t * (0.004817 + 0.000014 * t)) +
+          Math.sin(toRad(2 * m)) * (0.019993 - 0.000101 * t) +
+          Math.sin(toRad(3 * m)) * 0.000289;
+  var omega = 125.04 - 1934.136 * t;
+  var lambda = l0 + c - 0.00569 - 0.00478 * Math.sin(toRad(omega));
+  var eps0 = 23 + (26 + (21.448 - t * (46.815 + t * (0.00059 - t * 0.001813))) / 60) / 60;
+  var eps = eps0 + 0.00256 * Math.cos(toRad(omega));
+
+  var declination = toDeg(Math.asin(Math.sin(toRad(eps)) * Math.sin(toRad(lambda))));
+  var y = Math.pow(Math.tan(toRad(eps / 2)), 2);
+  var eqTime = 4 * toDeg(y * Math.sin(toRad(2 * l0)) -
+                         2 * e * Math.sin(toRad(m)) +
+                         4 * e * y * Math.sin(toRad(m)) * Math.cos(toRad(2 * l0)) -
+                         0.5 * y * y * Math.sin(toRad(4 * l0)) -
+                         1.25 * e * e * Math.sin(toRad(2 * m)));
+
+  return { declination: declination, eqTime: eqTime };
+}
+
+// UTC minutes of the event on the given UTC day, NaN if never, Infinity if always above
+function eventMinutesUtc(dayMs, latitude, longitude, zenith, rising) {
+  var minutes = 720 - 4 * longitude;
+
+  // Two passes: the second uses the sun's position at the first estimate
+  for (var pass = 0; pass < 2; pass++) {
+    var sun = solarPosition(dayMs + minutes * 60000);
+    var lat = toRad(latitude);
+    var decl = toRad(sun.declination);
+    var cosH = (Math.cos(toRad(zenith)) - Math.sin(lat) * Math.sin(decl)) /
+               (Math.cos(lat) * Math.cos(decl));
+
+    if (cosH > 1) return NaN;
+    if (cosH < -1) return Infinity;
+
+    var hourAngle = toDeg(Math.acos(cosH));
+    var noon = 720 - 4 * longitude - sun.eqTime;
+    minutes = rising ? noon - 4 * hourAngle : noon + 4 * hourAngle;
+  }
+  return minutes;
+}
+
+// Minutes since local midnight in a timezone for a UTC instant
+function localMinutes(utcMs, formatter) {
+  var parts = formatter.formatToParts(new Date(utcMs));
+  var hour = 0;
+  var minute = 0;
+  parts.forEach(function (part) {
+    if (part.type === 'hour') hour = parseInt(part.value, 10) % 24;
+    if (part.type === 'minute') minute = parseInt(part.value, 10);
+  });
+  return hour * 60 + minute;
+}
+
+// Begin/end of one phase for a day, in local minutes
+function phase(dayMs, location, zenith, formatter) {
+  var begin = eventMinutesUtc(dayMs, location.latitude, location.longitude, zenith, true);
+  var end = eventMinutesUtc(dayMs, location.latitude, location.longitude, zenith, false);
+
+  if (isNaN(begin) || isNaN(end)) return [-1, -1];
+  if (!isFinite(begin) || !isFinite(end)) return [0, 0];
+
+  return [
+    localMinutes(dayMs + Math.round(begin) * 60000, formatter),
+    localMinutes(dayMs + Math.round(end) * 60000, formatter)
+  ];
+}
+
+// First day of the table as a UTC midnight: config.start (YYYY-MM-DD) or today
+function startDate(config) {
+  if (!config.start) {
+    var now = new Date();
+    return Date.UTC(now.getFullYear(), now.getMonth(), now.getDate());
+  }
+
+  var match = /^(\d{4})-(\d{2})-(\d{2})$/.exec(config.start);
+  if (!match) throw new Error('saved_locations.json start must be YYYY-MM-DD');
+  return Date.UTC(parseInt(match[1], 10), parseInt(match[2], 10) - 1, parseInt(match[3], 10));
+}
+
+function formatDay(dayMs) {
+  return new Date(dayMs).toISOString().slice(0, 10);
+}
+
+function generate(config, startMs) {
+  var start = new Date(startMs);
+  var days = (Date.UTC(start.getUTCFullYear() + 1, start.getUTCMonth(), start.getUTCDate()) - startMs) / DAY_MS;
+  var locations = config.locations;
+
+  if (!locations || locations.length === 0 || locations.length > 255) {
+    throw new Error('saved_locations.json needs 1-255 locations');
+  }
+
+  var buffer = Buffer.alloc(HEADER_SIZE + locations.length * days * RECORD_SIZE);
+  buffer.write(MAGIC, 0, 'ascii');
+  buffer.writeUInt8(VERSION, 4);
+  buffer.writeUInt8(locations.length, 5);
+  buffer.writeUInt16LE(startMs / DAY_MS, 6);
+  buffer.writeUInt16LE(days, 8);
+  buffer.writeUInt16LE(RECORD_SIZE, 10);
+
+  var offset = HEADER_SIZE;
+  locations.forEach(function (location) {
+    var formatter = new Intl.DateTimeFormat('en-US', {
+      timeZone: location.tzid,
+      hour: '2-digit',
+      minute: '2-digit',
+      hourCycle: 'h23'
+    });
+
+    for (var day = 0; day < days; day++) {
+      var dayMs = startMs + day * DAY_MS;
+      var sun = phase(dayMs, location, ZENITH_SUNRISE, formatter);
+      var civil = phase(dayMs, location, ZENITH_CIVIL, formatter);
+      var nautical = phase(dayMs, location, ZENITH_NAUTICAL, formatter);
+      var astro = phase(dayMs, location, ZENITH_ASTRONOMICAL, formatter);
+
+      [astro[0], nautical[0], civil[0], sun[0], sun[1], civil[1], nautical[1], astro[1]]
+        .forEach(function (minutes) {
+          buffer.writeInt16LE(minutes, offset);
+          offset += 2;
+        });
+    }
+
+    console.log('Generated ' + days + ' days for ' + location.name);
+  });
+
+  return { buffer: buffer, days: days };
+}
+
+var config = JSON.parse(fs.readFileSync(CONFIG_FILE, 'utf8'));
+var startMs = startDate(config);
+var table = generate(config, startMs);
+fs.mkdirSync(path.dirname(OUTPUT_FILE), { recursive: true });
+fs.writeFileSync(OUTPUT_FILE, table.buffer);
+console.log('Wrote ' + table.buffer.length + ' bytes to ' + path.relative(ROOT, OUTPUT_FILE));
+
+// The phone needs the same range to know when the watch table applies
+var range = {
+  start: formatDay(startMs),
+  days: table.days,
+  last: formatDay(startMs + (table.days - 1) * DAY_MS)
+};
+fs.writeFileSync(RANGE_FILE, JSON.stringify(range, null, 2) + '\n');
+console.log('Table covers ' + range.start + ' to ' + range.last);
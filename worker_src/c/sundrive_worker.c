@@ -0,0 +1,176 @@
+#include <pebble_worker.h>
+#include "../../src/c/worker_shared.h"
+
+// Aggregates for today, persisted hourly and on exit
+static WorkerAggregates s_aggregates;
+
+// Step goal mirrored from the face, used to tell when the ring would move
+static int s_step_goal = 8000;
+
+// Last values pushed to the face (-1 = nothing sent yet)
+static int s_sent_step_span = -1;
+static int s_sent_battery = -1;
+
+// Save aggregates
+static void persist_aggregates() {
+  persist_write_data(STORAGE_KEY_WORKER_AGGREGATES, &s_aggregates, sizeof(WorkerAggregates));
+}
+
+// Step ring position in degrees (0-180): the face only redraws when this changes
+static int step_span(uint32_t steps) {
+  if (s_step_goal <= 0) return 0;
+  if (steps > (uint32_t)s_step_goal) steps = s_step_goal;
+  return (int)(steps * 180 / s_step_goal);
+}
+
+// Push steps to the face when the displayed ring would change
+static void push_steps(bool force) {
+  int span = step_span(s_aggregates.steps);
+  if (!force && span == s_sent_step_span) return;
+
+  AppWorkerMessage msg = {
+    .data0 = (uint16_t)(s_aggregates.steps >> 16),
+    .data1 = (uint16_t)(s_aggregates.steps & 0xFFFF),
+  };
+  app_worker_send_message(WORKER_MSG_STEPS, &msg);
+  s_sent_step_span = span;
+}
+
+// Push battery state to the face when it changes
+static void push_battery(bool force) {
+  int battery = s_aggregates.battery_percent | (s_aggregates.battery_charging ? 0x100 : 0);
+  if (!force && battery == s_sent_battery) return;
+
+  AppWorkerMessage msg = {
+    .data0 = s_aggregates.battery_percent,
+    .data1 = s_aggregates.battery_charging,
+  };
+  app_worker_send_message(WORKER_MSG_BATTERY, &msg);
+  s_sent_battery = battery;
+}
+
+// Start a fresh set of aggregates at midnight
+static void check_day_rollover() {
+  time_t today = time_start_of_today();
+  if (s_aggregates.day_start == today) return;
+
+  uint8_t percent = s_aggregates.battery_percent;
+  bool charging = s_aggregates.battery_charging;
+  memset(&s_aggregates, 0, sizeof(WorkerAggregates));
+  s_aggregates.day_start = today;
+  s_aggregates.battery_percent = percent;
+  s_aggregates.battery_charging = charging;
+}
+
+// Steps walked in [start, end), or 0 when health data is unavailable
+static uint32_t sum_steps(time_t start, time_t end) {
+  HealthServiceAccessibilityMask mask = health_service_metric_accessible(HealthMetricStepCount, start, end);
+  if (!(mask & HealthServiceAccessibilityMaskAvailable)) return 0;
+  return (uint32_t)health_service_sum(HealthMetricStepCount, start, end);
+}
+
+// Refresh the day total and the current hour's bucket
+static void update_steps() {
+  check_day_rollover();
+
+  time_t now = time(NULL);
+  time_t today = s_aggregates.day_start;
+  struct tm *local = localtime(&now);
+
+  // Wall-clock hour, like the hourly tick, so DST days fill the same slots
+  int hour = local->tm_hour;
+  time_t hour_start = now - local->tm_min * SECONDS_PER_MINUTE - local->tm_sec;
+
+  HealthServiceAccessibilityMask mask = health_service_metric_accessible(HealthMetricStepCount, today, now);
+  s_aggregates.steps = (mask & HealthServiceAccessibilityMaskAvailable) ?
+                       (uint32_t)health_service_sum_today(HealthMetricStepCount) : 0;
+
+  uint32_t hour_steps = sum_steps(hour_start, now);
+  s_aggregates.hourly_steps[hour] = (hour_steps > 0xFFFF) ? 0xFFFF : hour_steps;
+
+  push_steps(false);
+}
+
+// Health event handler
+static void health_handler(HealthEventType event, void *context) {
+  if (event == HealthEventMovementUpdate || event == HealthEventSignificantUpdate) {
+    update_steps();
+  }
+}
+
+// Battery state handler (fires only on change)
+static void battery_handler(BatteryChargeState state) {
+  s_aggregates.battery_percent = state.charge_percent;
+  s_aggregates.battery_charging = state.is_charging;
+  push_battery(false);
+}
+
+// Hourly bookkeeping: settle the hour that ended, sample the battery, persist
+static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+  time_t hour_start = time(NULL) - tick_time->tm_min * SECONDS_PER_MINUTE - tick_time->tm_sec;
+  int previous = (tick_time->tm_hour + WORKER_HOURS - 1) % WORKER_HOURS;
+  uint32_t hour_steps = sum_steps(hour_start - SECONDS_PER_HOUR, hour_start);
+  s_aggregates.hourly_steps[previous] = (hour_steps > 0xFFFF) ? 0xFFFF : hour_steps;
+
+  // Rolls the aggregates over at midnight
+  update_steps();
+
+  s_aggregates.battery_history[tick_time->tm_hour] = s_aggregates.battery_percent;
+  persist_aggregates();
+}
+
+// Messages from the face
+static void worker_message_handler(uint16_t type, AppWorkerMessage *data) {
+  if (type == WORKER_MSG_STEP_GOAL) {
+    s_step_goal = data->data0;
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Worker step goal: %d", s_step_goal);
+
+    // The face just (re)started or changed goal: give it everything it draws
+    push_steps(true);
+    push_battery(true);
+  }
+}
+
+// Worker initialization
+static void init(void) {
+  if (persist_exists(STORAGE_KEY_STEP_GOAL)) {
+    s_step_goal = persist_read_int(STORAGE_KEY_STEP_GOAL);
+  }
+
+  if (persist_exists(STORAGE_KEY_WORKER_AGGREGATES)) {
+    persist_read_data(STORAGE_KEY_WORKER_AGGREGATES, &s_aggregates, sizeof(WorkerAggregates));
+  }
+  check_day_rollover();
+
+  BatteryChargeState battery_state = battery_state_service_peek();
+  s_aggregates.battery_percent = battery_state.charge_percent;
+  s_aggregates.battery_charging = battery_state.is_charging;
+  battery_state_service_subscribe(battery_handler);
+
+  if (!health_service_events_subscribe(health_handler, NULL)) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Worker: health not available!");
+  }
+  update_steps();
+  push_battery(false);
+
+  app_worker_message_subscribe(worker_message_handler);
+  tick_timer_service_subscribe(HOUR_UNIT, tick_handler);
+
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Sundrive worker initialized");
+}
+
+// Worker deinitialization
+static void deinit(void) {
+  tick_timer_service_unsubscribe();
+  app_worker_message_unsubscribe();
+  health_service_events_unsubscribe();
+  battery_state_service_unsubscribe();
+  persist_aggregates();
+}
+
+// Main entry point
+int main(void) {
+  init();
+  worker_event_loop();
+  deinit();
+}